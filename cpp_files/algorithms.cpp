@@ -1,9 +1,14 @@
 #include "../headers/algorithms.h"
 
+// Natural runs shorter than this are extended by insertion sort before merging.
+const int MERGESORT_MIN_RUN = 8;
+// Size of the insertion-sorted blocks that in-place merge sort starts merging from.
+const int32_t INPLACE_MERGE_BLOCK_SIZE = 16;
+
 /**
 * Checks if a vector contains a sorted sequence of elements.
 */
-bool check_sorted(std::vector<uint16_t>& elems){
+bool check_sorted(const RecordArray& elems){
 	uint16_t last_elem = elems[0];
 	for (uint16_t i = 1; i < num_elems; i++){
 		if (elems[i] < last_elem)
@@ -17,8 +22,10 @@ bool check_sorted(std::vector<uint16_t>& elems){
 * A spectacularly inefficient sorting method, averages O((n+1)!) time.
 */
 void bogo_sort(){
+	uint16_t i;
 	while (!check_sorted(elems)){
-		std::shuffle(elems.begin(), elems.end(), generator);
+		for (i = num_elems - 1; i > 0; i--)
+			swap_elems(i, std::uniform_int_distribution<uint16_t>(0, i)(generator));
 		create_frame(elems);
 	}
 }
@@ -33,7 +40,7 @@ void bubble_sort(){
 		sorted = true;
 		for (j = 0; j < num_elems - i - 1; j++){
 			if (elems[j] > elems[j + 1]){
-				std::swap(elems[j], elems[j + 1]);
+				swap_elems(j, j + 1);
 				num_swaps++;
 				sorted = false;
 			}
@@ -54,7 +61,7 @@ void bubble_sort(){
 */
 void selection_sort(){
 	uint16_t i, j, min;
-	uint16_t n = elems.size();
+	uint16_t n = num_elems;
 
 	for (i = 0; i < n - 1; i++){
 		min = i;
@@ -71,7 +78,7 @@ void selection_sort(){
 			check_exit();
 		}
 		if (min != i){
-			std::swap(elems[min], elems[i]);
+			swap_elems(min, i);
 			num_swaps++;
 
 			// Visualization code below.
@@ -87,10 +94,10 @@ void selection_sort(){
 */
 void insertion_sort(){
 	uint16_t i, j;
-	for (i = 1; i < elems.size(); i++){
+	for (i = 1; i < num_elems; i++){
 		for (j = i; j > 0 && elems[j - 1] > elems[j]; j--){
 			num_comps++;
-			std::swap(elems[j], elems[j - 1]);
+			swap_elems(j, j - 1);
 			num_swaps++;
 
 			// Visualization code below.
@@ -122,15 +129,15 @@ uint16_t quicksort_partition(uint16_t start_idx, uint16_t end_idx){
 	// Set the pivot to the median of the first, middle, and last elements.
 	uint16_t mid_idx = (start_idx + end_idx) / 2;
 	if (elems[mid_idx] < elems[start_idx]){
-		std::swap(elems[start_idx], elems[mid_idx]);
+		swap_elems(start_idx, mid_idx);
 		num_swaps++;
 	}
 	if (elems[end_idx] < elems[start_idx]){
-		std::swap(elems[start_idx], elems[end_idx]);
+		swap_elems(start_idx, end_idx);
 		num_swaps++;
 	}
 	if (elems[mid_idx] < elems[end_idx]){
-		std::swap(elems[mid_idx], elems[end_idx]);
+		swap_elems(mid_idx, end_idx);
 		num_swaps++;
 	}
 	uint16_t pivot = elems[end_idx];
@@ -142,7 +149,7 @@ uint16_t quicksort_partition(uint16_t start_idx, uint16_t end_idx){
 		if (elems[j] < pivot){
 			elems_accessed.push_back(i);
 			if (i != j){
-				std::swap(elems[j], elems[i]);
+				swap_elems(j, i);
 				num_swaps++;
 			}
 			i++;
@@ -155,7 +162,7 @@ uint16_t quicksort_partition(uint16_t start_idx, uint16_t end_idx){
 		check_exit();
 	}
 	if (i < end_idx)
-		std::swap(elems[i], elems[end_idx]);
+		swap_elems(i, end_idx);
 	
 	elems_accessed.push_back(i);
 	elems_accessed.push_back(end_idx);
@@ -166,28 +173,93 @@ uint16_t quicksort_partition(uint16_t start_idx, uint16_t end_idx){
 
 /**
 * Mergesort, averages O(n*log(n)) time.
+* Seeds with natural runs (short runs are extended by insertion sort),
+* then merges adjacent runs back and forth between (elems) and a second
+* buffer, so each pass moves every element only once.
 */
 void bottom_up_mergesort(){
-	// Create copy of elems
-	std::vector<uint16_t> B(elems);
-
-	int32_t width;
-	uint16_t i, right_idx, end_idx;
-	for (width = 1; width < num_elems; width = 2 * width){
-		for (i = 0; i < num_elems; i = i + 2 * width){
-			right_idx = std::min(i+width, (int) num_elems);
-			end_idx = std::min(i+2*width, (int) num_elems);
-			bottom_up_merge(i, right_idx, end_idx, B);
+	ArenaMark mark = arena_mark();
+
+	// Find the starting index of each run; (runs) ends with num_elems
+	uint16_t* runs = arena_alloc_array<uint16_t>(num_elems + 1);
+	uint32_t runs_size = 0;
+	uint16_t run_start = 0;
+	while (run_start < num_elems){
+		runs[runs_size++] = run_start;
+		run_start = mergesort_seed_run(run_start);
+	}
+	runs[runs_size++] = num_elems;
+
+	// Second buffer; every pass writes all of (dst) before reading it, and frames
+	// only draw the part of (dst) already merged, so it needs no initial copy
+	RecordArray B = {arena_alloc_array<uint8_t>(num_elems * record_size)};
+	RecordArray src = elems;
+	RecordArray dst = B;
+
+	uint32_t i, num_runs;
+	while (runs_size > 2){
+		num_runs = 0;
+		for (i = 0; i + 1 < runs_size; i += 2){
+			if (i + 2 < runs_size)
+				bottom_up_merge(runs[i], runs[i + 1], runs[i + 2], src, dst);
+			else
+				bottom_up_merge(runs[i], runs[i + 1], runs[i + 1], src, dst);
+			runs[num_runs++] = runs[i];
 		}
-		// Copy B into elems
-		elems = B;
+		runs[num_runs++] = num_elems;
+		runs_size = num_runs;
+		std::swap(src, dst);
+	}
+
+	// The sorted sequence may have ended up in B
+	if (src.data != elems.data)
+		move_records(elems.data, B.data, num_elems);
+	arena_release(mark);
+}
+
+/**
+* Returns the end of the natural run beginning at (start_idx),
+* extending it with insertion sort to at least MERGESORT_MIN_RUN elements.
+*/
+uint16_t mergesort_seed_run(uint16_t start_idx){
+	uint16_t end_idx = start_idx + 1;
+	while (end_idx < num_elems){
+		num_comps++;
+		if (elems[end_idx] < elems[end_idx - 1])
+			break;
+		end_idx++;
 	}
+
+	uint16_t min_end = std::min(start_idx + MERGESORT_MIN_RUN, (int) num_elems);
+	if (end_idx < min_end){
+		insertion_sort_block(start_idx, end_idx, min_end);
+		end_idx = min_end;
+	}
+	return end_idx;
 }
 
 /**
-* Merge function of mergesort.
+* Merge function of mergesort, merges runs [left_idx, right_idx) and
+* [right_idx, end_idx) of (src) into the same range of (dst).
+* Frames draw (dst) up to the last merged index and (src) beyond it.
 */
-void bottom_up_merge(uint16_t left_idx, uint16_t right_idx, uint16_t end_idx, std::vector<uint16_t>& B){
+void bottom_up_merge(uint16_t left_idx, uint16_t right_idx, uint16_t end_idx,
+		const RecordArray& src, const RecordArray& dst){
+	// Runs already in order are moved across without merging.
+	if (right_idx == end_idx || src[right_idx - 1] <= src[right_idx]){
+		if (right_idx != end_idx)
+			num_comps++;
+		move_records(dst.record(left_idx), src.record(left_idx), end_idx - left_idx);
+		num_swaps += end_idx - left_idx;
+
+		elems_accessed.push_back(left_idx);
+		elems_accessed.push_back(end_idx - 1);
+		create_frame(FrameElems{dst, src, end_idx});
+
+		check_exit();
+		return;
+	}
+
 	uint16_t i = left_idx;
 	uint16_t j = right_idx;
 	uint16_t k;
@@ -196,17 +268,17 @@ void bottom_up_merge(uint16_t left_idx, uint16_t right_idx, uint16_t end_idx, st
 		elems_accessed.push_back(j);
 
 		num_comps++;
-		if (i < right_idx && (j >= end_idx || elems[i] <= elems[j])){
-			B[k] = elems[i];
+		if (i < right_idx && (j >= end_idx || src[i] <= src[j])){
+			move_records(dst.record(k), src.record(i));
 			i++;
 		} else {
-			B[k] = elems[j];
+			move_records(dst.record(k), src.record(j));
 			j++;
 		}
 		num_swaps++;
 
 		elems_accessed.push_back(k);
-		create_frame(B);
+		create_frame(FrameElems{dst, src, uint32_t(k + 1)});
 
 		check_exit();
 	}
@@ -214,12 +286,18 @@ void bottom_up_merge(uint16_t left_idx, uint16_t right_idx, uint16_t end_idx, st
 
 /**
 * Heapsort, averages O(n*log(n)) time.
+* Uses a (heap_arity)-ary heap; wider heaps are shallower, so a large
+* heap touches fewer cache lines per sift. Sibling groups start on
+* indices that are multiples of (heap_arity); see heap_first_child().
 */
 void heapsort(uint16_t start_idx, uint16_t end_idx){
+	ArenaMark mark = arena_mark();
+	temp_record = arena_alloc_array<uint8_t>(record_size);
+
 	heapify(start_idx, end_idx);
 	uint16_t end = end_idx - 1;
 	while (end > start_idx){
-		std::swap(elems[end], elems[start_idx]);
+		swap_elems(end, start_idx);
 		num_swaps++;
 
 		elems_accessed.push_back(start_idx);
@@ -231,6 +309,7 @@ void heapsort(uint16_t start_idx, uint16_t end_idx){
 		
 		check_exit();
 	}
+	arena_release(mark);
 }
 
 /**
@@ -245,57 +324,91 @@ void heapify(uint16_t start_idx, uint16_t end_idx){
 }
 
 /**
-* Sifting function of heapsort.
+* Sifting function of heapsort, using Floyd's bounce: descends to a leaf
+* along the path of largest children (heap_arity - 1 comparisons per level),
+* climbs back up to where the sifted element belongs, then shifts the path up.
 */
 void sift_down(uint16_t start_idx, uint16_t sift_idx, uint16_t end_idx){
-	uint16_t child, swap;
+	uint32_t child, last_child, largest;
 	uint16_t root = sift_idx;
-	while (heap_left_child(start_idx, root) <= end_idx){
-		child = heap_left_child(start_idx, root);
-		swap = root;
+	while ((child = heap_first_child(start_idx, root)) <= end_idx){
+		last_child = std::min(heap_last_child(start_idx, root), (uint32_t) end_idx);
+		largest = child;
 		elems_accessed.push_back(root);
+		elems_accessed.push_back(child);
+		for (child++; child <= last_child; child++){
+			num_comps++;
+			if (elems[largest] < elems[child])
+				largest = child;
+			elems_accessed.push_back(child);
+		}
+		root = largest;
+		create_frame(elems);
+	}
 
+	uint16_t value = elems[sift_idx];
+	while (root != sift_idx){
 		num_comps++;
-		if (elems[swap] < elems[child])
-			swap = child;
-		num_comps++;
-		if (child+1 <= end_idx && elems[swap] < elems[child+1])
-			swap = child + 1;
-		if (swap == root)
-			return;
-		else{
-			std::swap(elems[root], elems[swap]);
-			num_swaps++;
-			root = swap;
-			elems_accessed.push_back(root);
-		}
+		if (!(elems[root] < value))
+			break;
+		root = heap_parent(start_idx, root);
+	}
+	if (root == sift_idx)
+		return;
 
-		elems_accessed.push_back(child);
-		if (child+1 <= end_idx)
-			elems_accessed.push_back(child+1);
-		create_frame(elems);
+	// Move the sifted record to (root) and every record above it on the path up one level.
+	move_records(temp_record, elems.record(sift_idx));
+	while (root != sift_idx){
+		swap_records(elems.record(root), temp_record);
+		num_swaps++;
+		elems_accessed.push_back(root);
+		root = heap_parent(start_idx, root);
 	}
+	move_records(elems.record(sift_idx), temp_record);
+	num_swaps++;
+	elems_accessed.push_back(sift_idx);
+	create_frame(elems);
+}
+
+/**
+* Returns the number of children of the root of a heap starting at (start_idx),
+* between 1 and (heap_arity), chosen so that the root's children end just
+* before an index that is a multiple of (heap_arity).
+*/
+uint32_t heap_root_children(uint16_t start_idx){
+	uint32_t misalignment = (start_idx + 1) % heap_arity;
+	return misalignment ? heap_arity - misalignment : heap_arity;
 }
 
 /**
 * Returns the index of the parent of the given heap node.
 */
 uint16_t heap_parent(uint16_t start_idx, uint16_t i){
-	return start_idx + std::floor((i - start_idx - 1) / 2);
+	uint32_t root_children = heap_root_children(start_idx);
+	if (uint32_t(i - start_idx) <= root_children)
+		return start_idx;
+	return start_idx + (i - start_idx - root_children - 1) / heap_arity + 1;
 }
 
 /**
-* Returns the index of the left child of the given heap node.
+* Returns the index of the first child of the given heap node.
+* Every node but the root has (heap_arity) children, stored contiguously
+* from a multiple of (heap_arity); as (elems) is cache line aligned, each
+* sibling group shares one cache line when heap_arity * record_size divides 64.
 */
-uint16_t heap_left_child(uint16_t start_idx, uint16_t i){
-	return start_idx + 2*(i - start_idx) + 1;
+uint32_t heap_first_child(uint16_t start_idx, uint16_t i){
+	if (i == start_idx)
+		return start_idx + 1;
+	return start_idx + heap_root_children(start_idx) + heap_arity * uint32_t(i - start_idx - 1) + 1;
 }
 
 /**
-* Returns the index of the right child of the given heap node.
+* Returns the index of the last child of the given heap node.
 */
-uint16_t heap_right_child(uint16_t start_idx, uint16_t i){
-	return start_idx + 2*(i - start_idx) + 2;
+uint32_t heap_last_child(uint16_t start_idx, uint16_t i){
+	if (i == start_idx)
+		return start_idx + heap_root_children(start_idx);
+	return heap_first_child(start_idx, i) + heap_arity - 1;
 }
 
 /**
@@ -319,37 +432,182 @@ void introsort(uint16_t max_depth, uint16_t start_idx, uint16_t end_idx){
 * Shellsort, time complexity depends on gap sequence.
 */
 void shellsort(){
-	// Create gap sequence (simplified Tokuda)
-	std::vector<uint16_t> gaps;
-	uint32_t last_gap = 1;
-	while (last_gap < num_elems / 2){
-		gaps.push_back(last_gap);
-		last_gap = std::ceil(last_gap * 2.25 + 1);
-	}
-	std::reverse(gaps.begin(), gaps.end());
-
-	uint16_t i, j, k, temp, gap;
-	for (i = 0; i < gaps.size(); i++){
+	ArenaMark mark = arena_mark();
+	temp_record = arena_alloc_array<uint8_t>(record_size);
+
+	// Create gap sequence (simplified Tokuda), largest gap first
+	uint16_t num_gaps = 0;
+	uint32_t last_gap;
+	for (last_gap = 1; last_gap < num_elems / 2; last_gap = std::ceil(last_gap * 2.25 + 1))
+		num_gaps++;
+	uint16_t* gaps = arena_alloc_array<uint16_t>(num_gaps);
+	uint16_t i = num_gaps;
+	for (last_gap = 1; last_gap < num_elems / 2; last_gap = std::ceil(last_gap * 2.25 + 1))
+		gaps[--i] = last_gap;
+
+	uint16_t j, k, temp, gap;
+	for (i = 0; i < num_gaps; i++){
 		gap = gaps[i];
 		for (j = gap; j < num_elems; j++){
 			elems_accessed.push_back(j);
 			temp = elems[j];
+			move_records(temp_record, elems.record(j));
 			num_comps++;
 			for (k = j; k >= gap && elems[k - gap] > temp; k -= gap){
 				num_comps++;
 				elems_accessed.push_back(k);
 				elems_accessed.push_back(k - gap);
-				elems[k] = elems[k - gap];
+				move_records(elems.record(k), elems.record(k - gap));
 				num_swaps++;
 			}
 			elems_accessed.push_back(k);
-			elems[k] = temp;
+			move_records(elems.record(k), temp_record);
+			num_swaps++;
+
+			create_frame(elems);
+
+			check_exit();
+		}
+	}
+	arena_release(mark);
+}
+
+/**
+* In-place merge sort, stable and averaging O(n*log(n)^2) time.
+* Blocks are insertion sorted, then merged bottom-up using rotations
+* (SymMerge) rather than a scratch buffer; the rotations cost an extra
+* log(n) factor over mergesort.
+*/
+void inplace_merge_sort(){
+	int32_t width, i;
+	for (i = 0; i < num_elems; i += INPLACE_MERGE_BLOCK_SIZE)
+		insertion_sort_block(i, i + 1, std::min(i + INPLACE_MERGE_BLOCK_SIZE, (int32_t) num_elems));
+
+	for (width = INPLACE_MERGE_BLOCK_SIZE; width < num_elems; width = 2 * width)
+		for (i = 0; i + width < num_elems; i = i + 2 * width)
+			sym_merge(i, i + width, std::min(i + 2 * width, (int32_t) num_elems));
+}
+
+/**
+* Insertion sort of the elements in [start_idx, end_idx),
+* of which [start_idx, sorted_idx) are already in order.
+*/
+void insertion_sort_block(uint16_t start_idx, uint16_t sorted_idx, uint16_t end_idx){
+	uint16_t i, j;
+	for (i = sorted_idx; i < end_idx; i++){
+		for (j = i; j > start_idx && elems[j - 1] > elems[j]; j--){
+			num_comps++;
+			swap_elems(j, j - 1);
 			num_swaps++;
 
+			// Visualization code below.
+			elems_accessed.push_back(j);
+			elems_accessed.push_back(j - 1);
 			create_frame(elems);
 
 			check_exit();
 		}
+		if (j > start_idx)
+			num_comps++;
+	}
+}
+
+/**
+* Stable in-place merge of [start_idx, mid_idx) and [mid_idx, end_idx).
+* Splits both runs around the midpoint, rotates the middle section into
+* place, then recurses on each side (recursion depth is O(log(n))).
+*/
+void sym_merge(int32_t start_idx, int32_t mid_idx, int32_t end_idx){
+	num_comps++;
+	if (elems[mid_idx - 1] <= elems[mid_idx])
+		return;
+
+	int32_t lo, hi, cut;
+	if (mid_idx - start_idx == 1){
+		// Binary search for the position of the single left element.
+		lo = mid_idx;
+		hi = end_idx;
+		while (lo < hi){
+			cut = (lo + hi) / 2;
+			num_comps++;
+			if (elems[cut] < elems[start_idx])
+				lo = cut + 1;
+			else
+				hi = cut;
+		}
+		rotate_block(start_idx, mid_idx, lo);
+		return;
+	}
+	if (end_idx - mid_idx == 1){
+		// Binary search for the position of the single right element.
+		lo = start_idx;
+		hi = mid_idx;
+		while (lo < hi){
+			cut = (lo + hi) / 2;
+			num_comps++;
+			if (!(elems[mid_idx] < elems[cut]))
+				lo = cut + 1;
+			else
+				hi = cut;
+		}
+		rotate_block(lo, mid_idx, end_idx);
+		return;
+	}
+
+	int32_t half = (start_idx + end_idx) / 2;
+	int32_t n = half + mid_idx;
+	if (mid_idx > half){
+		lo = n - end_idx;
+		hi = half;
+	} else {
+		lo = start_idx;
+		hi = mid_idx;
+	}
+	while (lo < hi){
+		cut = (lo + hi) / 2;
+		num_comps++;
+		elems_accessed.push_back(n - 1 - cut);
+		elems_accessed.push_back(cut);
+		if (!(elems[n - 1 - cut] < elems[cut]))
+			lo = cut + 1;
+		else
+			hi = cut;
+	}
+	create_frame(elems);
+	check_exit();
+
+	int32_t end = n - lo;
+	if (lo < mid_idx && mid_idx < end)
+		rotate_block(lo, mid_idx, end);
+	if (start_idx < lo && lo < half)
+		sym_merge(start_idx, lo, half);
+	if (half < end && end < end_idx)
+		sym_merge(half, end, end_idx);
+}
+
+/**
+* Rotates [start_idx, end_idx) so that the element at mid_idx comes first.
+*/
+void rotate_block(int32_t start_idx, int32_t mid_idx, int32_t end_idx){
+	reverse_block(start_idx, mid_idx);
+	reverse_block(mid_idx, end_idx);
+	reverse_block(start_idx, end_idx);
+}
+
+/**
+* Reverses the elements in [start_idx, end_idx).
+*/
+void reverse_block(int32_t start_idx, int32_t end_idx){
+	for (end_idx--; start_idx < end_idx; start_idx++, end_idx--){
+		swap_elems(start_idx, end_idx);
+		num_swaps++;
+
+		// Visualization code below.
+		elems_accessed.push_back(start_idx);
+		elems_accessed.push_back(end_idx);
+		create_frame(elems);
+
+		check_exit();
 	}
 }
 
@@ -0,0 +1,80 @@
+#include "../headers/arena.h"
+#include "../globals.h"
+
+// Allocations are aligned to this many bytes, the size of a cache line.
+const size_t ARENA_ALIGNMENT = 64;
+
+// Backing memory of the arena, allocated once per run
+std::vector<uint8_t> arena_memory;
+// First ARENA_ALIGNMENT-aligned byte of (arena_memory); the offsets below are relative to it
+uint8_t* arena_origin = nullptr;
+// Usable size of the arena in bytes, starting at (arena_origin)
+size_t arena_size = 0;
+// Number of bytes in use from (arena_origin), alignment padding included
+size_t arena_used = 0;
+// Total bytes requested from the arena, without alignment padding
+size_t arena_requested = 0;
+// Value of (arena_requested) when sorting began; everything above it is the algorithm's scratch
+size_t arena_base = 0;
+
+/**
+* Allocates the arena that all scratch memory of this run is taken from.
+*/
+void arena_init(size_t capacity){
+	std::vector<uint8_t>(capacity + ARENA_ALIGNMENT).swap(arena_memory);
+	uintptr_t address = reinterpret_cast<uintptr_t>(arena_memory.data());
+	arena_origin = arena_memory.data() + (ARENA_ALIGNMENT - address % ARENA_ALIGNMENT) % ARENA_ALIGNMENT;
+	arena_size = capacity;
+	arena_used = arena_requested = arena_base = 0;
+}
+
+/**
+* Rounds (offset) up to the next multiple of ARENA_ALIGNMENT.
+*/
+size_t arena_align(size_t offset){
+	return (offset + ARENA_ALIGNMENT - 1) / ARENA_ALIGNMENT * ARENA_ALIGNMENT;
+}
+
+/**
+* Takes (bytes) from the arena. Exits if the arena is exhausted,
+* which means its capacity was computed too small.
+*/
+void* arena_alloc(size_t bytes){
+	size_t start = arena_align(arena_used);
+	if (start + bytes > arena_size){
+		std::cerr << "Error: Scratch arena exhausted (" << arena_size << " bytes)." << std::endl;
+		exit(1);
+	}
+	arena_used = start + bytes;
+	arena_requested += bytes;
+
+	if (arena_requested > arena_base){
+		aux_bytes = arena_requested - arena_base;
+		peak_aux_bytes = std::max(peak_aux_bytes, aux_bytes);
+	}
+	return arena_origin + start;
+}
+
+/**
+* Returns the current top of the arena, to be passed to arena_release().
+*/
+ArenaMark arena_mark(){
+	return ArenaMark{arena_used, arena_requested};
+}
+
+/**
+* Frees everything allocated since (mark) was taken.
+*/
+void arena_release(const ArenaMark& mark){
+	arena_used = mark.used;
+	arena_requested = mark.requested;
+	aux_bytes = arena_requested > arena_base ? arena_requested - arena_base : 0;
+}
+
+/**
+* Marks the start of sorting; later allocations count as the algorithm's auxiliary memory.
+*/
+void arena_start_run(){
+	arena_base = arena_requested;
+	aux_bytes = peak_aux_bytes = 0;
+}
@@ -0,0 +1,124 @@
+#include "../globals.h"
+#include "../headers/arena.h"
+
+/**
+* Returns byte (b) of the payload belonging to (key); payloads are derived
+* from their keys so that a payload separated from its key can be detected.
+*/
+uint8_t payload_byte(uint16_t key, uint16_t b){
+	return uint8_t(key * 31 + b);
+}
+
+/**
+* Fills a payload row with the bytes belonging to (key).
+*/
+void fill_payload(uint8_t* row, uint16_t key){
+	for (uint16_t b = 0; b < payload_size; b++)
+		row[b] = payload_byte(key, b);
+}
+
+/**
+* Sets (record_size) from the payload options.
+* In direct mode each record is its key followed by its (payload_size) byte
+* payload, so comparisons touch record-sized memory; in indirect mode it is
+* a key-index pair pointing at the payload's place in (payloads).
+*/
+void init_record_layout(){
+	// Bytes stored after each key: its payload, or its index into (payloads)
+	uint16_t satellite_size = indirect_sort ? sizeof(uint16_t) : payload_size;
+	record_size = sizeof(uint16_t) + satellite_size;
+	record_size += record_size % alignof(uint16_t);
+}
+
+/**
+* Creates the records to sort, one per key in (keys), in cache line
+* aligned arena memory.
+*/
+void create_records(const std::vector<uint16_t>& keys){
+	elems = RecordArray{arena_alloc_array<uint8_t>(num_elems * record_size)};
+
+	uint16_t i;
+	if (indirect_sort)
+		std::vector<uint8_t>(num_elems * payload_size).swap(payloads);
+	for (i = 0; i < num_elems; i++){
+		elems[i] = keys[i];
+		if (indirect_sort){
+			fill_payload(payloads.data() + i * payload_size, keys[i]);
+			memcpy(elems.satellite(i), &i, sizeof(uint16_t));
+		}
+		else
+			fill_payload(elems.satellite(i), keys[i]);
+	}
+}
+
+/**
+* Copies (count) consecutive records, counting their bytes towards (bytes_moved).
+*/
+void move_records(uint8_t* dst, const uint8_t* src, uint32_t count){
+	memcpy(dst, src, count * record_size);
+	bytes_moved += count * record_size;
+}
+
+/**
+* Exchanges two records.
+*/
+void swap_records(uint8_t* a, uint8_t* b){
+	std::swap_ranges(a, a + record_size, b);
+	bytes_moved += 2 * record_size;
+}
+
+/**
+* Swaps records (i) and (j) of (elems).
+*/
+void swap_elems(uint16_t i, uint16_t j){
+	swap_records(elems.record(i), elems.record(j));
+}
+
+/**
+* In indirect mode, moves every payload to the position its key was
+* sorted to. Follows each cycle of the permutation so that every
+* payload is moved exactly once.
+*/
+void permute_payloads(){
+	if (!indirect_sort || payload_size == 0)
+		return;
+
+	ArenaMark mark = arena_mark();
+	uint8_t* temp = arena_alloc_array<uint8_t>(payload_size);
+
+	uint16_t i, j, next;
+	for (i = 0; i < num_elems; i++){
+		memcpy(&next, elems.satellite(i), sizeof(uint16_t));
+		if (next == i)
+			continue;
+
+		memcpy(temp, &payloads[i * payload_size], payload_size);
+		j = i;
+		while (next != i){
+			memcpy(&payloads[j * payload_size], &payloads[next * payload_size], payload_size);
+			bytes_moved += payload_size;
+			memcpy(elems.satellite(j), &j, sizeof(uint16_t));
+			j = next;
+			memcpy(&next, elems.satellite(j), sizeof(uint16_t));
+		}
+		memcpy(&payloads[j * payload_size], temp, payload_size);
+		bytes_moved += payload_size;
+		memcpy(elems.satellite(j), &j, sizeof(uint16_t));
+	}
+	arena_release(mark);
+}
+
+/**
+* Checks that every element's payload still belongs to its key.
+*/
+bool check_records(){
+	const uint8_t* row;
+	uint16_t i, b;
+	for (i = 0; i < num_elems; i++){
+		row = indirect_sort ? payloads.data() + i * payload_size : elems.satellite(i);
+		for (b = 0; b < payload_size; b++)
+			if (row[b] != payload_byte(elems[i], b))
+				return 0;
+	}
+	return 1;
+}
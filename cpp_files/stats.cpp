@@ -0,0 +1,109 @@
+#include "../headers/stats.h"
+#include <fstream>
+
+const char* const PHASE_NAMES[NUM_PHASES] = {
+	"algorithm",
+	"view",
+	"text",
+	"present",
+	"delay"};
+
+// Time spent in each phase of the last completed frame
+double last_phase_ms[NUM_PHASES];
+// Ring buffer of the most recent total frame times
+float frame_history_ms[STATS_HISTORY];
+// Position in (frame_history_ms) that the next frame time is written to
+uint16_t frame_history_pos = 0;
+
+// Time spent in each phase of the frame in progress
+double frame_phase_ms[NUM_PHASES];
+// Performance counter value when the current phase began
+uint64_t phase_start;
+// Performance counter value when sorting began
+uint64_t stats_start_counter;
+// Total time spent in the algorithm phase, across all frames
+double total_algorithm_ms = 0;
+// Number of completed frames
+uint32_t frame_count = 0;
+
+std::ofstream stats_csv;
+
+/**
+* Starts timing; if (csv_path) is not empty, per-frame timings are also written there.
+*/
+void stats_start(const std::string& csv_path){
+	if (!csv_path.empty()){
+		stats_csv.open(csv_path);
+		if (!stats_csv)
+			std::cerr << "Could not open " << csv_path << " for writing." << std::endl;
+		else{
+			stats_csv << "frame";
+			for (uint8_t p = 0; p < NUM_PHASES; p++)
+				stats_csv << "," << PHASE_NAMES[p] << "_ms";
+			stats_csv << ",total_ms,comparisons,swaps\n";
+		}
+	}
+	phase_start = stats_start_counter = SDL_GetPerformanceCounter();
+}
+
+/**
+* Ends the current phase, attributing the time since the previous mark to (phase).
+*/
+void stats_mark(FramePhase phase){
+	uint64_t now = SDL_GetPerformanceCounter();
+	frame_phase_ms[phase] += double(now - phase_start) * 1000 / SDL_GetPerformanceFrequency();
+	phase_start = now;
+}
+
+/**
+* Records the phase timings of the frame just finished and starts a new one.
+*/
+void stats_end_frame(){
+	double total_ms = 0;
+	for (uint8_t p = 0; p < NUM_PHASES; p++)
+		total_ms += frame_phase_ms[p];
+	total_algorithm_ms += frame_phase_ms[PHASE_ALGORITHM];
+
+	if (stats_csv.is_open()){
+		stats_csv << frame_count;
+		for (uint8_t p = 0; p < NUM_PHASES; p++)
+			stats_csv << "," << frame_phase_ms[p];
+		stats_csv << "," << total_ms << "," << num_comps << "," << num_swaps << "\n";
+	}
+
+	frame_history_ms[frame_history_pos] = total_ms;
+	frame_history_pos = (frame_history_pos + 1) % STATS_HISTORY;
+	std::copy(frame_phase_ms, frame_phase_ms + NUM_PHASES, last_phase_ms);
+	std::fill(frame_phase_ms, frame_phase_ms + NUM_PHASES, 0);
+	frame_count++;
+
+	// Restart the clock so the bookkeeping above isn't charged to the algorithm.
+	phase_start = SDL_GetPerformanceCounter();
+}
+
+/**
+* Comparisons and swaps per second of time spent inside the algorithm.
+*/
+double stats_algorithm_ops_per_sec(){
+	if (total_algorithm_ms <= 0)
+		return 0;
+	return (double(num_comps) + num_swaps) * 1000 / total_algorithm_ms;
+}
+
+/**
+* Comparisons and swaps per second of wall time since sorting began.
+*/
+double stats_overall_ops_per_sec(){
+	double elapsed = double(SDL_GetPerformanceCounter() - stats_start_counter) / SDL_GetPerformanceFrequency();
+	if (elapsed <= 0)
+		return 0;
+	return (double(num_comps) + num_swaps) / elapsed;
+}
+
+/**
+* Flushes and closes the per-frame CSV, if one is being written.
+*/
+void stats_finish(){
+	if (stats_csv.is_open())
+		stats_csv.close();
+}
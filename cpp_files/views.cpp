@@ -0,0 +1,170 @@
+#include "../headers/views.h"
+#include <cmath>
+
+const View VIEWS[NUM_VIEWS] = {
+	{"bars", build_bar_view},
+	{"dots", build_dot_view},
+	{"colour circle", build_circle_view},
+	{"spiral", build_spiral_view}};
+
+// Number of times the spiral view winds around its centre.
+const float SPIRAL_TURNS = 4;
+
+// Vertices of the frame being built, submitted in a single draw call
+SDL_Vertex* vertices;
+uint32_t num_vertices = 0;
+// Triangles of the frame being built, as indices into (vertices)
+int* vertex_indices;
+uint32_t num_vertex_indices = 0;
+// Flags which indices of (elems) are listed in (elems_accessed)
+uint8_t* accessed_mask;
+
+/**
+* Takes room for the largest frame any view builds from the arena,
+* so building a frame never allocates.
+*/
+void init_views(){
+	vertices = arena_alloc_array<SDL_Vertex>(VIEW_VERTICES_PER_ELEM * num_elems);
+	vertex_indices = arena_alloc_array<int>(VIEW_INDICES_PER_ELEM * num_elems);
+	accessed_mask = arena_alloc_array<uint8_t>(num_elems);
+	std::fill(accessed_mask, accessed_mask + num_elems, 0);
+}
+
+/**
+* Returns the colour of element (i): red if it was accessed, otherwise (colour).
+*/
+SDL_Color element_colour(uint16_t i, const uint8_t colour[3]){
+	if (accessed_mask[i])
+		return SDL_Color{COLOUR_BARS_RED[0], COLOUR_BARS_RED[1], COLOUR_BARS_RED[2], 0xFF};
+	return SDL_Color{colour[0], colour[1], colour[2], 0xFF};
+}
+
+/**
+* Returns the fully saturated colour of (hue), in [0, 1).
+*/
+SDL_Color hue_colour(float hue){
+	float h = hue * 6;
+	uint8_t rising = (h - std::floor(h)) * 0xFF;
+	uint8_t falling = 0xFF - rising;
+	switch (int(h) % 6){
+		case 0: return SDL_Color{0xFF, rising, 0x00, 0xFF};
+		case 1: return SDL_Color{falling, 0xFF, 0x00, 0xFF};
+		case 2: return SDL_Color{0x00, 0xFF, rising, 0xFF};
+		case 3: return SDL_Color{0x00, falling, 0xFF, 0xFF};
+		case 4: return SDL_Color{rising, 0x00, 0xFF, 0xFF};
+		default: return SDL_Color{0xFF, 0x00, falling, 0xFF};
+	}
+}
+
+/**
+* Appends an axis-aligned rectangle with top-left corner (x, y) to the frame.
+*/
+void push_quad(float x, float y, float w, float h, SDL_Color colour){
+	int first = num_vertices;
+	vertices[num_vertices++] = SDL_Vertex{SDL_FPoint{x, y}, colour, SDL_FPoint{0, 0}};
+	vertices[num_vertices++] = SDL_Vertex{SDL_FPoint{x + w, y}, colour, SDL_FPoint{0, 0}};
+	vertices[num_vertices++] = SDL_Vertex{SDL_FPoint{x + w, y + h}, colour, SDL_FPoint{0, 0}};
+	vertices[num_vertices++] = SDL_Vertex{SDL_FPoint{x, y + h}, colour, SDL_FPoint{0, 0}};
+
+	const int corners[6] = {0, 1, 2, 0, 2, 3};
+	for (uint8_t i = 0; i < 6; i++)
+		vertex_indices[num_vertex_indices++] = first + corners[i];
+}
+
+/**
+* Appends a triangle to the frame.
+*/
+void push_triangle(SDL_FPoint a, SDL_FPoint b, SDL_FPoint c, SDL_Color colour){
+	int first = num_vertices;
+	vertices[num_vertices++] = SDL_Vertex{a, colour, SDL_FPoint{0, 0}};
+	vertices[num_vertices++] = SDL_Vertex{b, colour, SDL_FPoint{0, 0}};
+	vertices[num_vertices++] = SDL_Vertex{c, colour, SDL_FPoint{0, 0}};
+	for (uint8_t i = 0; i < 3; i++)
+		vertex_indices[num_vertex_indices++] = first + i;
+}
+
+/**
+* Vertical bars, one per element, with heights proportional to their values.
+*/
+void build_bar_view(const FrameElems& elems){
+	create_bars(elems);
+	for (uint16_t i = 0; i < num_elems; i++)
+		push_quad(bars[i].x, bars[i].y, bars[i].w, bars[i].h, element_colour(i, COLOUR_BARS_WHITE));
+}
+
+/**
+* A scatter plot of each element's value against its index.
+*/
+void build_dot_view(const FrameElems& elems){
+	float section_width = screen_width * (1 - 2 * SCREEN_MARGINS) / num_elems;
+	float plot_height = screen_height * (1 - 2 * SCREEN_MARGINS);
+	float dot_size = std::max(std::min(section_width, 8.0f), 2.0f);
+
+	float x, y;
+	for (uint16_t i = 0; i < num_elems; i++){
+		x = screen_width * SCREEN_MARGINS + section_width * (i + 0.5) - dot_size / 2;
+		y = screen_height * (1 - SCREEN_MARGINS) - float(elems[i]) / num_elems * plot_height - dot_size / 2;
+		push_quad(x, y, dot_size, dot_size, element_colour(i, COLOUR_BARS_WHITE));
+	}
+}
+
+/**
+* A colour wheel: each element is a wedge coloured by its value, whose length
+* shrinks with the distance between the element and its sorted position.
+*/
+void build_circle_view(const FrameElems& elems){
+	SDL_FPoint centre = {screen_width / 2.0f, screen_height / 2.0f};
+	float max_radius = std::min(screen_width, screen_height) * (1 - 2 * SCREEN_MARGINS) / 2;
+
+	float angle, next_angle, radius;
+	SDL_Color colour;
+	for (uint16_t i = 0; i < num_elems; i++){
+		angle = 2 * M_PI * i / num_elems - M_PI / 2;
+		next_angle = 2 * M_PI * (i + 1) / num_elems - M_PI / 2;
+		radius = max_radius * (1 - std::abs(int(elems[i]) - 1 - i) / float(num_elems));
+
+		colour = accessed_mask[i] ? element_colour(i, COLOUR_BARS_WHITE) : hue_colour(float(elems[i] - 1) / num_elems);
+		push_triangle(centre,
+			SDL_FPoint{centre.x + radius * std::cos(angle), centre.y + radius * std::sin(angle)},
+			SDL_FPoint{centre.x + radius * std::cos(next_angle), centre.y + radius * std::sin(next_angle)},
+			colour);
+	}
+}
+
+/**
+* Each element is a dot whose angle follows its index and whose distance from
+* the centre follows its value, so a sorted list traces an even spiral.
+*/
+void build_spiral_view(const FrameElems& elems){
+	SDL_FPoint centre = {screen_width / 2.0f, screen_height / 2.0f};
+	float max_radius = std::min(screen_width, screen_height) * (1 - 2 * SCREEN_MARGINS) / 2;
+	float dot_size = std::max(std::min(2 * float(M_PI) * max_radius / num_elems, 8.0f), 2.0f);
+
+	float angle, radius;
+	for (uint16_t i = 0; i < num_elems; i++){
+		angle = 2 * M_PI * SPIRAL_TURNS * i / num_elems;
+		radius = max_radius * elems[i] / num_elems;
+		push_quad(centre.x + radius * std::cos(angle) - dot_size / 2,
+			centre.y + radius * std::sin(angle) - dot_size / 2,
+			dot_size, dot_size, element_colour(i, COLOUR_BARS_WHITE));
+	}
+}
+
+/**
+* Draw (elems) using the selected view, in a single draw call.
+* Accessed elements are highlighted through their vertex colours.
+*/
+void draw_view(const FrameElems& elems){
+	uint32_t i;
+	for (i = 0; i < elems_accessed.size(); i++)
+		if (elems_accessed[i] < num_elems)
+			accessed_mask[elems_accessed[i]] = 1;
+
+	num_vertices = num_vertex_indices = 0;
+	VIEWS[view_mode].build(elems);
+	SDL_RenderGeometry(renderer, NULL, vertices, num_vertices, vertex_indices, num_vertex_indices);
+
+	for (i = 0; i < elems_accessed.size(); i++)
+		if (elems_accessed[i] < num_elems)
+			accessed_mask[elems_accessed[i]] = 0;
+}
@@ -1,9 +1,11 @@
 #include "../headers/visuals.h"
+#include "../headers/stats.h"
+#include "../headers/views.h"
 
 /**
 * Compute the dimensions of all bars, each representing an element in the list.
 */
-void create_bars(std::vector<uint16_t>& elems){
+void create_bars(const FrameElems& elems){
 	float bar_section_width = screen_width * (1 - 2 * SCREEN_MARGINS) / num_elems;
 	uint16_t bar_width = std::max(int(bar_section_width * (1 - BAR_SEPARATION)), 1);
 	
@@ -28,55 +30,106 @@ void create_bars(std::vector<uint16_t>& elems){
 }
 
 /**
-* Draw to the screen the element bars, using the appropriate colours.
+* Draw (text) to the screen in white with its top-left corner at (x, y).
+* SDL_ttf allocates a new surface and texture for every call.
 */
-void draw_bars(){
-	// Draw all bars in white.
-	SDL_SetRenderDrawColor(renderer, COLOUR_BARS_WHITE[0], COLOUR_BARS_WHITE[1], COLOUR_BARS_WHITE[2], 0xFF);
-	SDL_RenderFillRects(renderer, bars, num_elems);
-
-	// Draw accessed elements' bars again, but in red.
-	SDL_SetRenderDrawColor(renderer, COLOUR_BARS_RED[0], COLOUR_BARS_RED[1], COLOUR_BARS_RED[2], 0xFF);
-	for (uint16_t i = 0; i < elems_accessed.size(); i++)
-		SDL_RenderFillRect(renderer, &bars[elems_accessed[i]]);
+void render_text(TTF_Font *font, const char *text, int x, int y){
+	text_surface = TTF_RenderText_Shaded(font, text, {255, 255, 255}, {0, 0, 0});
+
+	int text_width = text_surface->w;
+	int text_height = text_surface->h;
+
+	SDL_Rect text_rect = SDL_Rect{x, y, text_width, text_height};
+	text_texture = SDL_CreateTextureFromSurface(renderer, text_surface);
+	SDL_RenderCopy(renderer, text_texture, NULL, &text_rect);
+
+	SDL_DestroyTexture(text_texture);
+	SDL_FreeSurface(text_surface);
 }
 
 /**
 * Draw to the screen the text specifying the number of comparisons and swaps.
 */
 void draw_text(){
-	std::string text_top = "Comparisons: " + std::to_string(num_comps);
-	text_top += "    Swaps: " + std::to_string(num_swaps);
-	text_surface = TTF_RenderText_Shaded(g_font, text_top.c_str(), {255, 255, 255}, {0, 0, 0});
+	static char text_top[128];
+	snprintf(text_top, sizeof(text_top), "Comparisons: %u    Swaps: %u    Aux memory: %u B",
+		num_comps, num_swaps, peak_aux_bytes);
 
 	int x = screen_width * SCREEN_MARGINS;
 	int y = screen_height * SCREEN_MARGINS * 0.15;
+	render_text(g_font, text_top, x, y);
+}
 
-	int text_width = text_surface->w;
-	int text_height = text_surface->h;
+/**
+* Draw to the screen the timing of the last frame, the operation throughput,
+* and a histogram of recent frame times in the bottom margin.
+*/
+void draw_stats(){
+	static char text_stats[256];
+	int len = snprintf(text_stats, sizeof(text_stats), "Frame %.2f ms =", last_phase_ms[PHASE_ALGORITHM]
+		+ last_phase_ms[PHASE_VIEW] + last_phase_ms[PHASE_TEXT] + last_phase_ms[PHASE_PRESENT] + last_phase_ms[PHASE_DELAY]);
+	for (uint8_t p = 0; p < NUM_PHASES && len < (int) sizeof(text_stats); p++)
+		len += snprintf(text_stats + len, sizeof(text_stats) - len, "%s%s %.2f",
+			p ? " + " : " ", PHASE_NAMES[p], last_phase_ms[p]);
+	if (len < (int) sizeof(text_stats))
+		snprintf(text_stats + len, sizeof(text_stats) - len, "    Ops/s: %.3e algorithm, %.3e overall",
+			stats_algorithm_ops_per_sec(), stats_overall_ops_per_sec());
 
-	SDL_Rect text_rect = SDL_Rect{x, y, text_width, text_height};
-	text_texture = SDL_CreateTextureFromSurface(renderer, text_surface);
-	SDL_RenderCopy(renderer, text_texture, NULL, &text_rect);
+	int x = screen_width * SCREEN_MARGINS;
+	int y = screen_height * SCREEN_MARGINS * 0.6;
+	render_text(g_stats_font, text_stats, x, y);
 
-	SDL_DestroyTexture(text_texture);
-	SDL_FreeSurface(text_surface);
+	// Histogram of frame times, oldest on the left.
+	float max_ms = *std::max_element(frame_history_ms, frame_history_ms + STATS_HISTORY);
+	if (max_ms <= 0)
+		return;
+	float hist_width = screen_width * 0.25;
+	float hist_height = screen_height * SCREEN_MARGINS * 0.7;
+	int hist_bottom = screen_height * (1 - SCREEN_MARGINS * 0.15);
+	int column_width = std::max(int(hist_width / STATS_HISTORY), 1);
+
+	SDL_Rect columns[STATS_HISTORY];
+	uint16_t i, column_height;
+	for (i = 0; i < STATS_HISTORY; i++){
+		column_height = frame_history_ms[(frame_history_pos + i) % STATS_HISTORY] / max_ms * hist_height;
+		columns[i] = SDL_Rect{int(x + i * hist_width / STATS_HISTORY), hist_bottom - column_height, column_width, column_height};
+	}
+	SDL_SetRenderDrawColor(renderer, COLOUR_STATS[0], COLOUR_STATS[1], COLOUR_STATS[2], 0xFF);
+	SDL_RenderFillRects(renderer, columns, STATS_HISTORY);
+}
+
+/**
+* Manages the creation and displaying of a new visual frame of (elems).
+*/
+void create_frame(const RecordArray& elems){
+	create_frame(FrameElems{elems, elems, num_elems});
 }
 
 /**
 * Manages the creation and displaying of a new visual frame.
 */
-void create_frame(std::vector<uint16_t>& elems){
+void create_frame(const FrameElems& elems){
+	// Time since the last frame was spent by the algorithm.
+	stats_mark(PHASE_ALGORITHM);
+
 	// Clear the renderer.
 	SDL_SetRenderDrawColor(renderer, COLOUR_BACKGROUND[0], COLOUR_BACKGROUND[1], COLOUR_BACKGROUND[2], 0xFF);
 	SDL_RenderClear(renderer);
 
-	create_bars(elems);
-	draw_bars();
+	draw_view(elems);
+	stats_mark(PHASE_VIEW);
+
 	draw_text();
+	if (show_stats)
+		draw_stats();
+	stats_mark(PHASE_TEXT);
 
 	// Update the screen.
 	SDL_RenderPresent(renderer);
+	stats_mark(PHASE_PRESENT);
+
 	elems_accessed.clear();
 	SDL_Delay(frame_delay_ms);
+	stats_mark(PHASE_DELAY);
+	stats_end_frame();
 }
\ No newline at end of file
@@ -8,11 +8,16 @@
 #include <signal.h>
 #include <getopt.h>
 #include <sstream>
+#include <cstdio>
+#include <cstring>
 
 #include <SDL2/SDL.h>
 #include <SDL2/SDL_ttf.h>
 #include <SDL2/SDL_image.h>
 
+#include "headers/arena.h"
+#include "headers/records.h"
+
 extern uint16_t screen_width;
 extern uint16_t screen_height;
 extern const float SCREEN_MARGINS;
@@ -21,22 +26,35 @@ extern const float BAR_SEPARATION;
 extern const uint8_t COLOUR_BACKGROUND[3];
 extern const uint8_t COLOUR_BARS_WHITE[3];
 extern const uint8_t COLOUR_BARS_RED[3];
+extern const uint8_t COLOUR_STATS[3];
 
 extern uint16_t frame_delay_ms;
 extern uint16_t num_elems;
+extern bool show_stats;
+extern uint8_t view_mode;
+extern uint8_t heap_arity;
 
 extern std::mt19937 generator;
 
-extern std::vector<uint16_t> elems;
-extern std::vector<uint16_t> elems_accessed;
+extern RecordArray elems;
+extern IndexList elems_accessed;
+
+extern uint16_t payload_size;
+extern bool indirect_sort;
+extern uint8_t* temp_record;
+extern std::vector<uint8_t> payloads;
 extern SDL_Rect *bars;
 
 extern uint32_t num_comps;
 extern uint32_t num_swaps;
+extern uint32_t aux_bytes;
+extern uint32_t peak_aux_bytes;
+extern uint64_t bytes_moved;
 
 extern SDL_Window *window;
 extern SDL_Renderer *renderer;
 extern TTF_Font *g_font;
+extern TTF_Font *g_stats_font;
 extern SDL_Surface *text_surface;
 extern SDL_Texture *text_texture;
 extern SDL_Event event;
@@ -3,8 +3,10 @@
 
 #include "../globals.h"
 #include "visuals.h"
+#include "records.h"
+#include "arena.h"
 
-bool check_sorted(std::vector<uint16_t>& elems);
+bool check_sorted(const RecordArray& elems);
 
 void bogo_sort();
 
@@ -20,7 +22,10 @@ uint16_t quicksort_partition(uint16_t start_idx, uint16_t end_idx);
 
 void bottom_up_mergesort();
 
-void bottom_up_merge(uint16_t left_idx, uint16_t right_idx, uint16_t end_idx, std::vector<uint16_t>& B);
+uint16_t mergesort_seed_run(uint16_t start_idx);
+
+void bottom_up_merge(uint16_t left_idx, uint16_t right_idx, uint16_t end_idx,
+		const RecordArray& src, const RecordArray& dst);
 
 void heapsort(uint16_t start_idx, uint16_t end_idx);
 
@@ -28,16 +33,28 @@ void heapify(uint16_t start_idx, uint16_t end_idx);
 
 void sift_down(uint16_t start_idx, uint16_t start, uint16_t end);
 
+uint32_t heap_root_children(uint16_t start_idx);
+
 uint16_t heap_parent(uint16_t start_idx, uint16_t i);
 
-uint16_t heap_left_child(uint16_t start_idx, uint16_t i);
+uint32_t heap_first_child(uint16_t start_idx, uint16_t i);
 
-uint16_t heap_right_child(uint16_t start_idx, uint16_t i);
+uint32_t heap_last_child(uint16_t start_idx, uint16_t i);
 
 void introsort(uint16_t max_depth, uint16_t start_idx, uint16_t end_idx);
 
 void shellsort();
 
+void inplace_merge_sort();
+
+void insertion_sort_block(uint16_t start_idx, uint16_t sorted_idx, uint16_t end_idx);
+
+void sym_merge(int32_t start_idx, int32_t mid_idx, int32_t end_idx);
+
+void rotate_block(int32_t start_idx, int32_t mid_idx, int32_t end_idx);
+
+void reverse_block(int32_t start_idx, int32_t end_idx);
+
 void check_exit();
 
 #endif
\ No newline at end of file
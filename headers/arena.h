@@ -0,0 +1,51 @@
+#ifndef __ARENA_H__
+#define __ARENA_H__
+
+#include <cstdint>
+#include <cstddef>
+#include <cassert>
+
+// Fixed-capacity list of element indices backed by arena memory.
+// Pushes beyond the capacity assert in debug builds and are dropped otherwise.
+struct IndexList {
+	uint16_t *data;
+	uint32_t count;
+	uint32_t capacity;
+
+	void push_back(uint16_t i){
+		assert(count < capacity);
+		if (count < capacity)
+			data[count++] = i;
+	}
+	uint32_t size() const { return count; }
+	uint16_t operator[](uint32_t i) const { return data[i]; }
+	void clear(){ count = 0; }
+};
+
+// Position of the arena to return to with arena_release().
+struct ArenaMark {
+	size_t used;
+	size_t requested;
+};
+
+void arena_init(size_t capacity);
+
+size_t arena_align(size_t offset);
+
+void* arena_alloc(size_t bytes);
+
+/**
+* Allocates room for (count) objects of type T from the arena.
+*/
+template <typename T>
+T* arena_alloc_array(size_t count){
+	return static_cast<T*>(arena_alloc(count * sizeof(T)));
+}
+
+ArenaMark arena_mark();
+
+void arena_release(const ArenaMark& mark);
+
+void arena_start_run();
+
+#endif
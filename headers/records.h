@@ -0,0 +1,35 @@
+#ifndef __RECORDS_H__
+#define __RECORDS_H__
+
+#include <cstdint>
+#include <vector>
+
+extern uint16_t record_size;
+
+// View of an array of records, each a uint16_t key followed by its
+// satellite data and padded to (record_size) bytes.
+struct RecordArray {
+	uint8_t *data;
+
+	uint16_t& operator[](uint32_t i) const {
+		return *reinterpret_cast<uint16_t*>(data + i * record_size);
+	}
+	uint8_t* record(uint32_t i) const { return data + i * record_size; }
+	uint8_t* satellite(uint32_t i) const { return data + i * record_size + sizeof(uint16_t); }
+};
+
+void init_record_layout();
+
+void create_records(const std::vector<uint16_t>& keys);
+
+void move_records(uint8_t* dst, const uint8_t* src, uint32_t count = 1);
+
+void swap_records(uint8_t* a, uint8_t* b);
+
+void swap_elems(uint16_t i, uint16_t j);
+
+void permute_payloads();
+
+bool check_records();
+
+#endif
@@ -0,0 +1,37 @@
+#ifndef __STATS_H__
+#define __STATS_H__
+
+#include "../globals.h"
+
+// Parts of a frame that are timed separately.
+enum FramePhase {
+	PHASE_ALGORITHM,
+	PHASE_VIEW,
+	PHASE_TEXT,
+	PHASE_PRESENT,
+	PHASE_DELAY,
+	NUM_PHASES
+};
+
+// Number of frames kept for the frame time histogram.
+const uint16_t STATS_HISTORY = 120;
+
+extern const char* const PHASE_NAMES[NUM_PHASES];
+
+extern double last_phase_ms[NUM_PHASES];
+extern float frame_history_ms[STATS_HISTORY];
+extern uint16_t frame_history_pos;
+
+void stats_start(const std::string& csv_path);
+
+void stats_mark(FramePhase phase);
+
+void stats_end_frame();
+
+double stats_algorithm_ops_per_sec();
+
+double stats_overall_ops_per_sec();
+
+void stats_finish();
+
+#endif
@@ -0,0 +1,45 @@
+#ifndef __VIEWS_H__
+#define __VIEWS_H__
+
+#include "../globals.h"
+#include "visuals.h"
+
+// A way of drawing (elems), which builds a whole frame into (vertices) and (vertex_indices).
+struct View {
+	std::string name;
+	void (*build)(const FrameElems& elems);
+};
+
+const uint8_t NUM_VIEWS = 4;
+// Most vertices and triangle indices any view uses per element (a quad).
+const uint8_t VIEW_VERTICES_PER_ELEM = 4;
+const uint8_t VIEW_INDICES_PER_ELEM = 6;
+extern const View VIEWS[NUM_VIEWS];
+
+extern SDL_Vertex* vertices;
+extern uint32_t num_vertices;
+extern int* vertex_indices;
+extern uint32_t num_vertex_indices;
+extern uint8_t* accessed_mask;
+
+void init_views();
+
+SDL_Color element_colour(uint16_t i, const uint8_t colour[3]);
+
+SDL_Color hue_colour(float hue);
+
+void push_quad(float x, float y, float w, float h, SDL_Color colour);
+
+void push_triangle(SDL_FPoint a, SDL_FPoint b, SDL_FPoint c, SDL_Color colour);
+
+void build_bar_view(const FrameElems& elems);
+
+void build_dot_view(const FrameElems& elems);
+
+void build_circle_view(const FrameElems& elems);
+
+void build_spiral_view(const FrameElems& elems);
+
+void draw_view(const FrameElems& elems);
+
+#endif
@@ -3,12 +3,26 @@
 
 #include "../globals.h"
 
-void create_bars(std::vector<uint16_t>& elems);
+// The elements a frame draws: those of (merged) before index (split) and those
+// of (rest) from it on, so that a merge between two buffers is drawn as it stands.
+struct FrameElems {
+	RecordArray merged;
+	RecordArray rest;
+	uint32_t split;
 
-void draw_bars();
+	uint16_t operator[](uint32_t i) const { return i < split ? merged[i] : rest[i]; }
+};
+
+void create_bars(const FrameElems& elems);
+
+void render_text(TTF_Font *font, const char *text, int x, int y);
 
 void draw_text();
 
-void create_frame(std::vector<uint16_t>& elems);
+void draw_stats();
+
+void create_frame(const RecordArray& elems);
+
+void create_frame(const FrameElems& elems);
 
 #endif
\ No newline at end of file
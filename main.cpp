@@ -1,16 +1,24 @@
 #include "globals.h"
 #include "headers/visuals.h"
 #include "headers/algorithms.h"
+#include "headers/stats.h"
+#include "headers/views.h"
 
 const option long_opts[] = {
 	{"frame-delay", 1, 0, 'd'},
 	{"dimensions", 1, 0, 'z'},
 	{"help", 0, 0, 'h'},
 	{"sorting", 1, 0, 's'},
+	{"heap-arity", 1, 0, 'a'},
+	{"payload", 1, 0, 'p'},
+	{"indirect", 0, 0, 'i'},
+	{"view", 1, 0, 'v'},
+	{"stats", 0, 0, 't'},
+	{"stats-csv", 1, 0, 'c'},
 	{0,0,0,0}
 };
 
-const std::string sort_method_names[8] = {
+const std::string sort_method_names[9] = {
 	"bubble sort",
 	"selection sort",
 	"insertion sort",
@@ -18,7 +26,8 @@ const std::string sort_method_names[8] = {
 	"mergesort",
 	"heapsort",
 	"introsort",
-	"shellsort"};
+	"shellsort",
+	"in-place merge sort (SymMerge)"};
 
 // Screen properties.
 const uint16_t DEFAULT_SCREEN_WIDTH = 1500;
@@ -33,23 +42,51 @@ uint16_t screen_height = DEFAULT_SCREEN_HEIGHT;
 const uint8_t COLOUR_BACKGROUND[3] = {0x00, 0x00, 0x00};
 const uint8_t COLOUR_BARS_WHITE[3] = {0xFF, 0xFF, 0xFF};
 const uint8_t COLOUR_BARS_RED[3] = {0xFF, 0x00, 0x00};
+const uint8_t COLOUR_STATS[3] = {0x80, 0x80, 0x80};
 
 // Default parameters.
 const uint16_t DEFAULT_NUM_ELEMS = 50;
 const uint16_t DEFAULT_FRAME_DELAY_MS = 50;
 const uint16_t DEFAULT_SORT_METHOD = 3;
+const uint8_t DEFAULT_HEAP_ARITY = 2;
+const uint8_t DEFAULT_VIEW_MODE = 0;
+const uint16_t DEFAULT_PAYLOAD_SIZE = 0;
+const uint16_t MIN_PAYLOAD_SIZE = 8;
+const uint16_t MAX_PAYLOAD_SIZE = 256;
+
+// Scratch arena headroom for alignment padding and small buffers (gap sequence, temp rows).
+const size_t ARENA_SLACK = 4096;
 
 uint16_t num_elems = DEFAULT_NUM_ELEMS;
 uint16_t frame_delay_ms = DEFAULT_FRAME_DELAY_MS;
 uint16_t sort_method = DEFAULT_SORT_METHOD;
+// Number of children per node in heapsort's heap
+uint8_t heap_arity = DEFAULT_HEAP_ARITY;
+// Index into (VIEWS) of the view used to draw the elements
+uint8_t view_mode = DEFAULT_VIEW_MODE;
+// Whether to draw the frame timing panel
+bool show_stats = false;
+// File that per-frame timings are written to, if any
+std::string stats_csv_path;
 
 std::random_device random_dev;
 std::mt19937 generator(random_dev());
 
-// Stores the list of elements to sort
-std::vector<uint16_t> elems;
+// Stores the list of elements to sort, as records in arena memory
+RecordArray elems;
 // Tracks which indices of (elems) have been accessed in a period of operations
-std::vector<uint16_t> elems_accessed;
+IndexList elems_accessed;
+
+// Size in bytes of the payload carried by each record, 0 for bare keys
+uint16_t payload_size = DEFAULT_PAYLOAD_SIZE;
+// Whether to sort key-index pairs and permute the payloads once afterwards
+bool indirect_sort = false;
+// Size in bytes of each record of (elems), key and payload or payload index included
+uint16_t record_size = sizeof(uint16_t);
+// Scratch record for algorithms that hold an element aside
+uint8_t* temp_record;
+// Holds the record payloads when sorting indirectly
+std::vector<uint8_t> payloads;
 // Holds the rectangles that visually represent the elements in (elems)
 SDL_Rect *bars;
 
@@ -57,10 +94,17 @@ SDL_Rect *bars;
 uint32_t num_comps = 0;
 // Records the number of element swaps
 uint32_t num_swaps = 0;
+// Bytes of scratch memory currently held by the sorting method
+uint32_t aux_bytes = 0;
+// Largest value (aux_bytes) has reached
+uint32_t peak_aux_bytes = 0;
+// Records the number of bytes written while moving records
+uint64_t bytes_moved = 0;
 
 SDL_Window *window;
 SDL_Renderer *renderer;
 TTF_Font *g_font;
+TTF_Font *g_stats_font;
 SDL_Surface *text_surface;
 SDL_Texture *text_texture;
 SDL_Event event;
@@ -84,7 +128,7 @@ void signal_interrupt(int _){
 /**
 * Prints out each element of a vector, separated by a newline.
 */
-void print_elems(std::vector<uint16_t>& elems, uint16_t num_elems){
+void print_elems(const RecordArray& elems, uint16_t num_elems){
 	for(int i = 0; i < num_elems; i++)
 		std::cout << elems[i] << std::endl;
 	std::cout << std::endl;
@@ -96,13 +140,15 @@ void print_elems(std::vector<uint16_t>& elems, uint16_t num_elems){
 void load_font(){
 	int font_size = screen_height * SCREEN_MARGINS / 3;
 	g_font = TTF_OpenFont("fonts/Roboto/Roboto-Regular.ttf", font_size);
+	g_stats_font = TTF_OpenFont("fonts/Roboto/Roboto-Regular.ttf", font_size * 2 / 3);
 }
 
 /**
 * Called on exit, Frees and destroys.
 */
 void exit_function(){
-	std::vector<uint16_t>().swap(elems);
+	stats_finish();
+	std::vector<uint8_t>().swap(payloads);
 	SDL_DestroyWindow(window);
 	SDL_DestroyRenderer(renderer);
 	SDL_Quit();
@@ -114,7 +160,7 @@ int main(int argc, char *argv[]){
 
 	// Process passed arguments
 	int opt;
-	while((opt = getopt_long(argc, argv, "hn:d:s:", long_opts, &optind)) != EOF){
+	while((opt = getopt_long(argc, argv, "hn:d:s:a:p:v:", long_opts, &optind)) != EOF){
 		switch(opt){
 			case 'h':
 				std::cout << std::endl << "Options:\n";
@@ -131,6 +177,15 @@ int main(int argc, char *argv[]){
 				std::cout << "    5: heapsort\n";
 				std::cout << "    6: introsort\n";
 				std::cout << "    7: shellsort\n";
+				std::cout << "    8: in-place merge sort (SymMerge)\n";
+				std::cout << " -p N, --payload N           payload bytes per record: 0 or " << MIN_PAYLOAD_SIZE << "-" << MAX_PAYLOAD_SIZE << " (default: " << DEFAULT_PAYLOAD_SIZE << ")\n";
+				std::cout << " --indirect                  sort key-index pairs, then permute the payloads once\n";
+				std::cout << " -v N, --view N              how the elements are drawn (default: " << VIEWS[DEFAULT_VIEW_MODE].name << ")\n";
+				for (uint8_t v = 0; v < NUM_VIEWS; v++)
+					std::cout << "    " << int(v) << ": " << VIEWS[v].name << "\n";
+				std::cout << " --stats                     show frame timings and throughput\n";
+				std::cout << " --stats-csv FILE            write per-frame timings to FILE\n";
+				std::cout << " -a N, --heap-arity N        children per heap node in heapsort/introsort: 2, 4 or 8 (default: " << int(DEFAULT_HEAP_ARITY) << ")\n";
 				std::cout << std::endl << std::endl;
 				return 0;
 
@@ -153,7 +208,7 @@ int main(int argc, char *argv[]){
 				break;
 
 			case 's':
-				if (std::atoi(optarg) >= 0 && std::atoi(optarg) < 8){
+				if (std::atoi(optarg) >= 0 && std::atoi(optarg) < 9){
 					sort_method = std::atoi(optarg);
 					std::cout << "Sorting method set to " << sort_method_names[sort_method] << "." << std::endl;
 				}
@@ -161,6 +216,46 @@ int main(int argc, char *argv[]){
 					std::cerr << "Invalid sorting method. Defaulting to " << sort_method_names[sort_method] << "." << std::endl;
 				break;
 
+			case 'a':
+				if (std::atoi(optarg) == 2 || std::atoi(optarg) == 4 || std::atoi(optarg) == 8){
+					heap_arity = std::atoi(optarg);
+					std::cout << "Heap arity set to " << int(heap_arity) << "." << std::endl;
+				}
+				else
+					std::cerr << "Invalid heap arity. Defaulting to " << int(heap_arity) << "." << std::endl;
+				break;
+
+			case 'p':
+				if (std::atoi(optarg) == 0 || (std::atoi(optarg) >= MIN_PAYLOAD_SIZE && std::atoi(optarg) <= MAX_PAYLOAD_SIZE)){
+					payload_size = std::atoi(optarg);
+					std::cout << "Payload size set to " << payload_size << " bytes." << std::endl;
+				}
+				else
+					std::cerr << "Invalid payload size. Defaulting to " << payload_size << " bytes." << std::endl;
+				break;
+
+			case 'i':
+				indirect_sort = true;
+				std::cout << "Sorting indirectly." << std::endl;
+				break;
+
+			case 'v':
+				if (std::atoi(optarg) >= 0 && std::atoi(optarg) < NUM_VIEWS){
+					view_mode = std::atoi(optarg);
+					std::cout << "View set to " << VIEWS[view_mode].name << "." << std::endl;
+				}
+				else
+					std::cerr << "Invalid view. Defaulting to " << VIEWS[view_mode].name << "." << std::endl;
+				break;
+
+			case 't':
+				show_stats = true;
+				break;
+
+			case 'c':
+				stats_csv_path = optarg;
+				break;
+
 			case 'z':
 				// case for "dimensions" option, gathers dimensions from optarg in form "XxY".
 				std::stringstream ss(optarg);
@@ -217,19 +312,35 @@ int main(int argc, char *argv[]){
 
 	// Load the TTF font
 	load_font();
-	if (g_font == NULL){
+	if (g_font == NULL || g_stats_font == NULL){
 		std::cerr << "Font load error." << std::endl;
 		return 1;
 	}
 
+	// Create the arena, sized for the records, the renderer and the largest
+	// need of any sorting method (mergesort's run list and second buffer)
+	init_record_layout();
+	size_t access_capacity = 2 * num_elems + 16;
+	size_t render_bytes = num_elems * (sizeof(SDL_Rect) + 1
+		+ VIEW_VERTICES_PER_ELEM * sizeof(SDL_Vertex) + VIEW_INDICES_PER_ELEM * sizeof(int))
+		+ access_capacity * sizeof(uint16_t);
+	size_t sort_bytes = (num_elems + 1) * sizeof(uint16_t) + (num_elems + 1) * record_size
+		+ payload_size;
+	arena_init(num_elems * record_size + render_bytes + sort_bytes + ARENA_SLACK);
+
 	// Create and shuffle (num_elems) elements
-	std::vector<uint16_t>(num_elems).swap(elems);
-	std::iota(std::begin(elems), std::end(elems), 1);
-	std::shuffle(elems.begin(), elems.end(), generator);
+	std::vector<uint16_t> keys(num_elems);
+	std::iota(keys.begin(), keys.end(), 1);
+	std::shuffle(keys.begin(), keys.end(), generator);
+	create_records(keys);
 
 	// Create array for the bar Rects
-	SDL_Rect arr[num_elems];
-	bars = arr;
+	bars = arena_alloc_array<SDL_Rect>(num_elems);
+	elems_accessed = IndexList{arena_alloc_array<uint16_t>(access_capacity), 0, uint32_t(access_capacity)};
+	init_views();
+
+	stats_start(stats_csv_path);
+	arena_start_run();
 
 	uint16_t depth;
 	// Sort using the specified/default sort method
@@ -259,18 +370,28 @@ int main(int argc, char *argv[]){
 		case 7:
 			shellsort();
 			break;
+		case 8:
+			inplace_merge_sort();
+			break;
 	}
 
+	// Move the payloads into place if only their indices were sorted
+	permute_payloads();
+
 	// Show sorted list
 	create_frame(elems);
 
-	if (check_sorted(elems))
-		std::cout << "\nSorted!\n\n";
-	else
+	if (!check_sorted(elems))
 		std::cerr << "\nError: Sorting Failure!\n\n";
+	else if (!check_records())
+		std::cerr << "\nError: Payloads separated from their keys!\n\n";
+	else
+		std::cout << "\nSorted!\n\n";
 		
 	std::cout << "Total comparisons: " << num_comps << std::endl;
 	std::cout << "Total swaps: " << num_swaps << std::endl;
+	std::cout << "Bytes moved: " << bytes_moved << std::endl;
+	std::cout << "Peak auxiliary memory: " << peak_aux_bytes << " bytes" << std::endl;
 
 	// Pause after sorting is complete
 	SDL_Delay(2000);